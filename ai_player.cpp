@@ -1,16 +1,24 @@
 // ai_player.cpp
 #include "ai_player.h"
 #include "game_logic.h"
+#include "opening_book.h"
+#include "policy_net.h"
 #include <cstdlib>
-#include <ctime>
 #include <algorithm>
 #include <vector>
 
-AIPlayer::AIPlayer() {
-    srand(static_cast<unsigned int>(time(nullptr)));
+// 随机种子由 main 统一设置，这样录制的输入可以复现同样的AI行为
+AIPlayer::AIPlayer() : m_book(&shared_opening_book()), m_book_symmetry(0) {
+    // 没有开局库时不消耗随机数，保持与原来相同的随机序列
+    if (m_book->is_loaded()) m_book_symmetry = rand() % BOOK_SYMMETRIES;
     reset();
 }
 
+void AIPlayer::set_opening_book(const OpeningBook* book, int symmetry) {
+    m_book = book;
+    m_book_symmetry = symmetry;
+}
+
 // 重置AI状态，在每局游戏开始时调用
 void AIPlayer::reset() {
     m_state = AIState::HUNTING; // 初始状态为搜索
@@ -84,7 +92,20 @@ Point AIPlayer::make_shot(const CellState opponent_view[GRID_SIZE][GRID_SIZE]) {
     }
 
     // --- 搜索模式逻辑 ---
-    // 随机射击一个没有打过的点
+    // 开局的前几手直接查开局库
+    Point book_shot;
+    if (m_book && m_book->lookup(opponent_view, book_shot, m_book_symmetry)) {
+        return book_shot;
+    }
+
+    // 如果有训练好的策略网络，由网络选出得分最高的格子
+    const PolicyNet& policy = shared_policy_net();
+    if (policy.is_loaded()) {
+        Point best = policy.best_shot(opponent_view);
+        if (best.r != -1) return best;
+    }
+
+    // 否则随机射击一个没有打过的点
     Point shot;
     do {
         shot = { rand() % GRID_SIZE, rand() % GRID_SIZE };
@@ -3,6 +3,8 @@
 #include "common.h"
 #include <vector>
 
+class OpeningBook;
+
 // 定义AI的两种工作状态
 enum class AIState {
     HUNTING,    // 搜索模式：随机寻找目标
@@ -20,7 +22,13 @@ public:
 
     void reset();
 
+    // 更换开局库及查表时使用的对称变换 (默认使用 shared_opening_book() 和随机变换)，离线生成开局库时使用
+    void set_opening_book(const OpeningBook* book, int symmetry);
+    bool is_hunting() const { return m_state == AIState::HUNTING; }
+
 private:
     AIState m_state;                // AI当前的状态 (使用 m_ 前缀是成员变量的好习惯)
     std::vector<Point> m_target_hits; // 在摧毁模式下，存储已击中的船体部分坐标
+    const OpeningBook* m_book;        // 搜索模式下前几手查询的开局库
+    int m_book_symmetry;              // 查开局库时对局面施加的对称变换，每个AI随机选择，避免每局开局完全相同
 };
\ No newline at end of file
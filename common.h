@@ -1,7 +1,11 @@
 // common.h
 #pragma once // 防止头文件被重复包含
 
+#ifdef SEAWAR_HEADLESS
+#include "headless_graphics.h" // 无窗口的空实现，用于 Linux / CI 上回放 trace
+#else
 #include <graphics.h>
+#endif
 #include <vector>
 #include <string>
 
@@ -1,12 +1,12 @@
 // graphics.cpp
 #include "graphics.h"
 #include "game_logic.h"
+#include "text_cache.h"
 #include <string>
 
 IMAGE g_imgGradientBg;
-// 辅助函数：根据格子状态获取颜色
-// 设为 static，限制作用域
-static COLORREF get_cell_color(CellState state) {
+// 辅助函数：根据格子状态获取颜色 (观战墙也使用同一套颜色)
+COLORREF get_cell_color(CellState state) {
     switch (state) {
     case CellState::EMPTY: return RGB(173, 216, 230);
     case CellState::SHIP:  return DARKGRAY; // <--- 修正颜色
@@ -41,9 +41,7 @@ void create_gradient_background() {
 
 void draw_main_menu(int selected_item) {
     //cleardevice();
-    settextstyle(60, 0, L"Impact");
-    settextcolor(DARKGRAY);
-    outtextxy(340, 80, L"BATTLESHIP");
+    draw_cached_text(340, 80, L"BATTLESHIP", 60, L"Impact", DARKGRAY);
 
     const wchar_t* items[] = { L"人机对战", L"双人对战", L"退出游戏" };
     for (int i = 0; i < 3; ++i) {
@@ -54,10 +52,7 @@ void draw_main_menu(int selected_item) {
             setfillcolor(RGB(176, 196, 222)); // 普通颜色
         }
         solidroundrect(300, 200 + i * 80, 600, 260 + i * 80, 10, 10);
-        setbkmode(TRANSPARENT);
-        settextcolor(WHITE);
-        settextstyle(32, 0, L"微软雅黑");
-        outtextxy(390, 215 + i * 80, items[i]);
+        draw_cached_text(390, 215 + i * 80, items[i], 32, L"微软雅黑", WHITE);
     }
 }
 
@@ -82,9 +77,7 @@ void draw_game_board(int x, int y, const PlayerBoard& board, bool show_ships) {
 
 void draw_placement_screen(const PlayerBoard& board, const Ship& current_ship_preview, bool placement_valid) {
     //cleardevice();
-    settextstyle(24, 0, L"微软雅黑");
-    settextcolor(BLACK);
-    outtextxy(100, 20, L"请放置你的舰船 (右键旋转, 左键放置)");
+    draw_cached_text(100, 20, L"请放置你的舰船 (右键旋转, 左键放置)", 24, L"微软雅黑", BLACK);
 
     draw_game_board(100, 60, board, true);
 
@@ -108,16 +101,14 @@ void draw_game_interface(const PlayerBoard& p1, const PlayerBoard& p2, GameState
     int p2_board_x = WINDOW_WIDTH - p1_board_x - GRID_SIZE * CELL_SIZE;
     int board_y = 100;
 
-    settextstyle(24, 0, L"微软雅黑");
-    settextcolor(BLACK);
     // 优化PVP模式下的标题
     if (mode == GameMode::PLAYER_VS_PLAYER && (current_state == GameState::PLAYER2_TURN || current_state == GameState::PLAYER1_TURN)) {
-        outtextxy(p1_board_x, 60, L"玩家1 的棋盘");
-        outtextxy(p2_board_x, 60, L"玩家2 的棋盘");
+        draw_cached_text(p1_board_x, 60, L"玩家1 的棋盘", 24, L"微软雅黑", BLACK);
+        draw_cached_text(p2_board_x, 60, L"玩家2 的棋盘", 24, L"微软雅黑", BLACK);
     }
     else {
-        outtextxy(p1_board_x, 60, L"你的棋盘");
-        outtextxy(p2_board_x, 60, L"对手棋盘");
+        draw_cached_text(p1_board_x, 60, L"你的棋盘", 24, L"微软雅黑", BLACK);
+        draw_cached_text(p2_board_x, 60, L"对手棋盘", 24, L"微软雅黑", BLACK);
     }
 
     bool show_p1_ships = (mode == GameMode::PLAYER_VS_AI || current_state != GameState::PLAYER2_TURN);
@@ -133,8 +124,8 @@ void draw_game_interface(const PlayerBoard& p1, const PlayerBoard& p2, GameState
         draw_game_board(p2_board_x, board_y, p2, false);
     }
 
-    settextstyle(30, 0, L"Impact");
-    std::wstring status_text;
+    // 状态文字都是字面量，用指针即可，避免每帧分配 std::wstring
+    const wchar_t* status_text = L"";
     switch (current_state) {
     case GameState::PLAYER1_TURN: status_text = L"玩家1 回合 (攻击右侧)"; break;
         // 优化PVP提示
@@ -145,7 +136,7 @@ void draw_game_interface(const PlayerBoard& p1, const PlayerBoard& p2, GameState
         else status_text = (mode == GameMode::PLAYER_VS_AI) ? L"AI 获胜!" : L"玩家2 获胜!";
         break;
     }
-    outtextxy(WINDOW_WIDTH / 2 - 120, 20, status_text.c_str());
+    draw_cached_text(WINDOW_WIDTH / 2 - 120, 20, status_text, 30, L"Impact", BLACK);
 }
 
 Point get_grid_click(int mouse_x, int mouse_y, int grid_start_x, int grid_start_y) {
@@ -9,5 +9,6 @@ void draw_main_menu(int selected_item);
 void draw_game_board(int x, int y, const PlayerBoard& board, bool show_ships);
 void draw_placement_screen(const PlayerBoard& board, const Ship& current_ship_preview, bool placement_valid);
 void draw_game_interface(const PlayerBoard& p1, const PlayerBoard& p2, GameState current_state, GameMode mode);
+COLORREF get_cell_color(CellState state);
 Point get_grid_click(int mouse_x, int mouse_y, int grid_start_x, int grid_start_y);
 extern IMAGE g_imgGradientBg;
\ No newline at end of file
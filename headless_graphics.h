@@ -0,0 +1,121 @@
+// headless_graphics.h
+// 定义 SEAWAR_HEADLESS 时代替 EasyX 的 <graphics.h>：只提供本项目用到的接口，全部为空操作，
+// 用于在没有窗口的环境 (Linux / CI) 中编译并回放输入 trace。
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cwchar>
+#include <thread>
+
+typedef unsigned long COLORREF;
+typedef unsigned char BYTE;
+typedef unsigned long DWORD;
+
+#define RGB(r, g, b) ((COLORREF)(((BYTE)(r) | ((unsigned)((BYTE)(g)) << 8)) | (((DWORD)(BYTE)(b)) << 16)))
+#define GetRValue(c) ((BYTE)(c))
+#define GetGValue(c) ((BYTE)((c) >> 8))
+#define GetBValue(c) ((BYTE)((c) >> 16))
+
+#define BLACK     0x000000
+#define RED       0x0000AA
+#define GREEN     0x00AA00
+#define DARKGRAY  0x555555
+#define WHITE     0xFFFFFF
+
+#define TRANSPARENT 1
+#define SRCCOPY     0x00CC0020
+#define SRCPAINT    0x00EE0086
+#define SRCAND      0x008800C6
+
+#define LF_FACESIZE            32
+#define NONANTIALIASED_QUALITY 3
+
+#define WM_KEYFIRST     0x0100
+#define WM_KEYDOWN      0x0100
+#define WM_CHAR         0x0102
+#define WM_KEYLAST      0x0109
+#define WM_MOUSEFIRST   0x0200
+#define WM_MOUSEMOVE    0x0200
+#define WM_LBUTTONDOWN  0x0201
+#define WM_RBUTTONDOWN  0x0204
+#define WM_MOUSELAST    0x020E
+
+#define EX_MOUSE  1
+#define EX_KEY    2
+#define EX_CHAR   4
+#define EX_WINDOW 8
+
+struct ExMessage {
+    unsigned short message;
+    union {
+        struct { bool ctrl : 1, shift : 1, lbutton : 1, mbutton : 1, rbutton : 1; short x, y, wheel; };
+        struct { BYTE vkcode, scancode; bool extended : 1, prevdown : 1; };
+        wchar_t ch;
+    };
+};
+
+struct LOGFONT {
+    long lfHeight;
+    long lfWidth;
+    long lfEscapement;
+    long lfOrientation;
+    long lfWeight;
+    BYTE lfItalic;
+    BYTE lfUnderline;
+    BYTE lfStrikeOut;
+    BYTE lfCharSet;
+    BYTE lfOutPrecision;
+    BYTE lfClipPrecision;
+    BYTE lfQuality;
+    BYTE lfPitchAndFamily;
+    wchar_t lfFaceName[LF_FACESIZE];
+};
+
+class IMAGE {
+public:
+    IMAGE(int width = 0, int height = 0) : m_width(width), m_height(height) {}
+    void Resize(int width, int height) { m_width = width; m_height = height; }
+    int getwidth() const { return m_width; }
+    int getheight() const { return m_height; }
+private:
+    int m_width, m_height;
+};
+
+// 当前字号，用于给出确定的文字尺寸
+static long g_headless_text_height = 16;
+
+inline void Sleep(DWORD ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+inline void initgraph(int, int) {}
+inline void closegraph() {}
+inline void BeginBatchDraw() {}
+inline void FlushBatchDraw() {}
+inline void EndBatchDraw() {}
+inline void SetWorkingImage(IMAGE*) {}
+inline void putimage(int, int, const IMAGE*, DWORD = SRCCOPY) {}
+inline void cleardevice() {}
+
+inline void settextstyle(int height, int, const wchar_t*) { g_headless_text_height = height; }
+inline void settextstyle(const LOGFONT* font) { g_headless_text_height = font->lfHeight; }
+inline void gettextstyle(LOGFONT* font) {
+    *font = LOGFONT();
+    font->lfHeight = g_headless_text_height;
+}
+inline void settextcolor(COLORREF) {}
+inline void setbkmode(int) {}
+inline void setbkcolor(COLORREF) {}
+inline void outtextxy(int, int, const wchar_t*) {}
+inline int textwidth(const wchar_t* text) { return static_cast<int>(wcslen(text) * g_headless_text_height / 2); }
+inline int textheight(const wchar_t*) { return static_cast<int>(g_headless_text_height); }
+
+inline void setfillcolor(COLORREF) {}
+inline void setlinecolor(COLORREF) {}
+inline void solidrectangle(int, int, int, int) {}
+inline void rectangle(int, int, int, int) {}
+inline void solidroundrect(int, int, int, int, int, int) {}
+inline void line(int, int, int, int) {}
+
+// 没有窗口也就没有实时输入，无界面版本只能通过 --replay 驱动
+inline bool peekmessage(ExMessage*, BYTE = 0xFF, bool = true) { return false; }
+inline ExMessage getmessage(BYTE = 0xFF) { return ExMessage(); }
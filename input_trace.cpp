@@ -0,0 +1,308 @@
+// input_trace.cpp
+#include "input_trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const char TRACE_MAGIC[] = "SWTRACE";
+static const int TRACE_VERSION = 2;
+static const char TRACE_END[] = "END";
+
+// 一条录制的输入事件，只保存游戏逻辑会用到的字段
+struct TraceEvent {
+    long long time_ms;      // 相对录制开始的时间
+    unsigned short message;
+    int a, b;               // 鼠标消息: x, y；键盘消息: vkcode, 0；字符消息: ch, 0
+};
+
+static InputMode s_mode = InputMode::LIVE;
+static std::string s_path;
+static FILE* s_record_file = nullptr;
+static Clock::time_point s_start;
+
+// 最近一次记录的双方棋盘校验和
+static bool s_has_boards = false;
+static uint64_t s_board_checksum = 0;
+
+// 回放状态
+static std::vector<TraceEvent> s_events;
+static size_t s_next_event = 0;
+static size_t s_delivered_events = 0; // 实际送给游戏的事件数 (不含被 filter 丢弃的)
+
+// 回放统计：每个事件从送出到下一个事件送出之间的耗时和绘制的帧数
+static std::vector<double> s_event_us;
+static std::vector<int> s_event_frames;
+static Clock::time_point s_last_event_time;
+static int s_frames_since_event = 0;
+static int s_total_frames = 0;
+static double s_p95_limit_us = 0;
+static bool s_has_expected_checksum = false;
+static uint64_t s_expected_checksum = 0;
+
+static BYTE message_category(unsigned short message) {
+    if (message >= WM_MOUSEFIRST && message <= WM_MOUSELAST) return EX_MOUSE;
+    if (message == WM_CHAR) return EX_CHAR;
+    if (message >= WM_KEYFIRST && message <= WM_KEYLAST) return EX_KEY;
+    return EX_WINDOW;
+}
+
+static TraceEvent to_trace_event(const ExMessage& msg) {
+    TraceEvent ev = {};
+    ev.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - s_start).count();
+    ev.message = msg.message;
+    switch (message_category(msg.message)) {
+    case EX_MOUSE: ev.a = msg.x; ev.b = msg.y; break;
+    case EX_KEY:   ev.a = msg.vkcode; break;
+    case EX_CHAR:  ev.a = msg.ch; break;
+    }
+    return ev;
+}
+
+static ExMessage to_message(const TraceEvent& ev) {
+    ExMessage msg = {};
+    msg.message = ev.message;
+    switch (message_category(ev.message)) {
+    case EX_MOUSE: msg.x = static_cast<short>(ev.a); msg.y = static_cast<short>(ev.b); break;
+    case EX_KEY:   msg.vkcode = static_cast<BYTE>(ev.a); break;
+    case EX_CHAR:  msg.ch = static_cast<wchar_t>(ev.a); break;
+    }
+    return msg;
+}
+
+bool start_input_recording(const std::string& path, const TraceEnvironment& env) {
+    s_record_file = fopen(path.c_str(), "w");
+    if (!s_record_file) return false;
+    fprintf(s_record_file, "%s %d %u %d %016llx %d %016llx\n", TRACE_MAGIC, TRACE_VERSION, env.seed,
+        env.policy_loaded ? 1 : 0, static_cast<unsigned long long>(env.policy_hash),
+        env.book_loaded ? 1 : 0, static_cast<unsigned long long>(env.book_hash));
+    s_path = path;
+    s_mode = InputMode::RECORD;
+    s_start = Clock::now();
+    return true;
+}
+
+bool start_input_replay(const std::string& path, TraceEnvironment& recorded) {
+    FILE* fp = fopen(path.c_str(), "r");
+    if (!fp) return false;
+
+    char magic[16] = {};
+    int version = 0, policy_loaded = 0, book_loaded = 0;
+    unsigned long long policy_hash = 0, book_hash = 0;
+    if (fscanf(fp, "%15s %d %u %d %llx %d %llx", magic, &version, &recorded.seed,
+            &policy_loaded, &policy_hash, &book_loaded, &book_hash) != 7 ||
+        std::string(magic) != TRACE_MAGIC || version != TRACE_VERSION) {
+        fclose(fp);
+        return false;
+    }
+    recorded.policy_loaded = policy_loaded != 0;
+    recorded.policy_hash = policy_hash;
+    recorded.book_loaded = book_loaded != 0;
+    recorded.book_hash = book_hash;
+
+    s_events.clear();
+    TraceEvent ev;
+    unsigned int message;
+    while (fscanf(fp, "%lld %u %d %d", &ev.time_ms, &message, &ev.a, &ev.b) == 4) {
+        ev.message = static_cast<unsigned short>(message);
+        s_events.push_back(ev);
+    }
+    // 事件之后是可选的结束行 "END <棋盘校验和>"，窗口被直接关闭的录制没有这一行
+    unsigned long long checksum = 0;
+    s_has_expected_checksum = fscanf(fp, " END %llx", &checksum) == 1;
+    s_expected_checksum = checksum;
+    fclose(fp);
+
+    s_path = path;
+    s_mode = InputMode::REPLAY;
+    s_next_event = 0;
+    s_delivered_events = 0;
+    s_event_us.clear();
+    s_event_frames.clear();
+    s_frames_since_event = 0;
+    s_total_frames = 0;
+    s_start = Clock::now();
+    s_last_event_time = s_start;
+    return true;
+}
+
+InputMode current_input_mode() {
+    return s_mode;
+}
+
+void set_replay_p95_limit(double us) {
+    s_p95_limit_us = us;
+}
+
+void note_trace_boards(const PlayerBoard& p1, const PlayerBoard& p2) {
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    const PlayerBoard* boards[] = { &p1, &p2 };
+    for (const PlayerBoard* board : boards) {
+        for (int r = 0; r < GRID_SIZE; ++r) {
+            for (int c = 0; c < GRID_SIZE; ++c) {
+                hash ^= static_cast<uint64_t>(board->grid[r][c]);
+                hash *= 0x100000001B3ULL;
+            }
+        }
+    }
+    s_board_checksum = hash;
+    s_has_boards = true;
+}
+
+// 结算上一个事件的耗时和帧数
+static void close_current_event(Clock::time_point now) {
+    if (s_delivered_events == 0) return; // 第一个事件之前的时间不归属于任何事件
+    s_event_us.push_back(std::chrono::duration<double, std::micro>(now - s_last_event_time).count());
+    s_event_frames.push_back(s_frames_since_event);
+}
+
+/**
+ * @brief 写出回放统计并做校验：棋盘校验和必须与录制时一致，p95 不能超过上限。
+ * @return 校验是否通过。
+ */
+static bool write_replay_report() {
+    Clock::time_point now = Clock::now();
+    close_current_event(now);
+
+    std::vector<double> sorted = s_event_us;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    double p95 = n > 0 ? sorted[std::min(n - 1, n * 95 / 100)] : 0;
+    bool checksum_ok = !s_has_expected_checksum || (s_has_boards && s_board_checksum == s_expected_checksum);
+    bool p95_ok = s_p95_limit_us <= 0 || p95 <= s_p95_limit_us;
+    if (!checksum_ok) {
+        fprintf(stderr, "replay diverged: board checksum %016llx, expected %016llx\n",
+            static_cast<unsigned long long>(s_board_checksum), static_cast<unsigned long long>(s_expected_checksum));
+    }
+    if (!p95_ok) {
+        fprintf(stderr, "replay too slow: p95 %.1f us exceeds limit %.1f us\n", p95, s_p95_limit_us);
+    }
+
+    std::string report_path = s_path + ".report";
+    FILE* fp = fopen(report_path.c_str(), "w");
+    if (!fp) return false;
+
+    double total_ms = std::chrono::duration<double, std::milli>(now - s_start).count();
+    fprintf(fp, "trace: %s\n", s_path.c_str());
+    fprintf(fp, "events: %zu\n", s_events.size());
+    fprintf(fp, "delivered: %zu\n", s_delivered_events);
+    fprintf(fp, "frames: %d\n", s_total_frames);
+    fprintf(fp, "total_ms: %.3f\n", total_ms);
+
+    if (n > 0) {
+        double sum = 0;
+        for (double us : sorted) sum += us;
+        int max_frames = 0;
+        long long frame_sum = 0;
+        for (int f : s_event_frames) {
+            frame_sum += f;
+            max_frames = std::max(max_frames, f);
+        }
+        fprintf(fp, "event_us_mean: %.1f\n", sum / n);
+        fprintf(fp, "event_us_p50: %.1f\n", sorted[n / 2]);
+        fprintf(fp, "event_us_p95: %.1f\n", p95);
+        fprintf(fp, "event_us_max: %.1f\n", sorted.back());
+        fprintf(fp, "frames_per_event_mean: %.2f\n", static_cast<double>(frame_sum) / n);
+        fprintf(fp, "frames_per_event_max: %d\n", max_frames);
+    }
+    if (s_has_boards) {
+        fprintf(fp, "board_checksum: %016llx\n", static_cast<unsigned long long>(s_board_checksum));
+    }
+    else {
+        fprintf(fp, "board_checksum: none\n");
+    }
+    if (s_has_expected_checksum) {
+        fprintf(fp, "expected_checksum: %016llx\n", static_cast<unsigned long long>(s_expected_checksum));
+    }
+    else {
+        fprintf(fp, "expected_checksum: none\n");
+    }
+    if (s_p95_limit_us > 0) {
+        fprintf(fp, "p95_limit_us: %.1f\n", s_p95_limit_us);
+    }
+    fprintf(fp, "result: %s\n", (checksum_ok && p95_ok) ? "ok" : "FAIL");
+    fclose(fp);
+    return checksum_ok && p95_ok;
+}
+
+bool finish_input_trace() {
+    bool ok = true;
+    if (s_mode == InputMode::RECORD && s_record_file) {
+        if (s_has_boards) {
+            fprintf(s_record_file, "%s %016llx\n", TRACE_END, static_cast<unsigned long long>(s_board_checksum));
+        }
+        fclose(s_record_file);
+        s_record_file = nullptr;
+    }
+    else if (s_mode == InputMode::REPLAY) {
+        ok = write_replay_report();
+    }
+    s_mode = InputMode::LIVE;
+    return ok;
+}
+
+/**
+ * @brief 取出下一个符合 filter 的回放事件。trace 用完时输出统计并结束程序。
+ */
+static bool next_replay_event(ExMessage* msg, BYTE filter) {
+    while (s_next_event < s_events.size()) {
+        const TraceEvent& ev = s_events[s_next_event++];
+        // 与实时模式一致，不符合 filter 的消息直接丢弃，也不计入统计
+        if (message_category(ev.message) & filter) {
+            Clock::time_point now = Clock::now();
+            close_current_event(now);
+            s_last_event_time = now;
+            s_frames_since_event = 0;
+            ++s_delivered_events;
+            *msg = to_message(ev);
+            return true;
+        }
+    }
+
+    // 回放结束：各个界面循环都是无限循环，只能在这里退出
+    bool ok = finish_input_trace();
+    EndBatchDraw();
+    closegraph();
+    exit(ok ? 0 : 1);
+}
+
+bool poll_input(ExMessage* msg, BYTE filter) {
+    if (s_mode == InputMode::REPLAY) {
+        return next_replay_event(msg, filter);
+    }
+    if (!peekmessage(msg, filter)) return false;
+    if (s_mode == InputMode::RECORD) {
+        TraceEvent ev = to_trace_event(*msg);
+        fprintf(s_record_file, "%lld %u %d %d\n", ev.time_ms, static_cast<unsigned int>(ev.message), ev.a, ev.b);
+        fflush(s_record_file); // 玩家可能直接关闭窗口，每条都写到磁盘
+    }
+    return true;
+}
+
+ExMessage wait_input(BYTE filter) {
+    ExMessage msg;
+    if (s_mode == InputMode::REPLAY) {
+        next_replay_event(&msg, filter);
+        return msg;
+    }
+    while (!poll_input(&msg, filter)) {
+        Sleep(1);
+    }
+    return msg;
+}
+
+void present_frame() {
+    FlushBatchDraw();
+    ++s_frames_since_event;
+    ++s_total_frames;
+}
+
+void frame_sleep(DWORD ms) {
+    if (s_mode != InputMode::REPLAY) {
+        Sleep(ms);
+    }
+}
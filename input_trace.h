@@ -0,0 +1,39 @@
+// input_trace.h
+#pragma once
+#include "common.h"
+#include <cstdint>
+#include <string>
+
+// 输入来源：实时 / 实时并录制到文件 / 从文件回放
+enum class InputMode {
+    LIVE,
+    RECORD,
+    REPLAY
+};
+
+// 影响 AI 行为的运行环境。录制时写入 trace 头，回放前必须与当前环境一致，否则同样的输入会作用在不同的对局上
+struct TraceEnvironment {
+    unsigned int seed;
+    bool policy_loaded;
+    uint64_t policy_hash;
+    bool book_loaded;
+    uint64_t book_hash;
+};
+
+// 开始录制，env 会写入文件头
+bool start_input_recording(const std::string& path, const TraceEnvironment& env);
+// 开始回放，成功时通过 recorded 返回录制时的环境 (由调用方与当前环境比较)
+bool start_input_replay(const std::string& path, TraceEnvironment& recorded);
+// 回放时每个事件耗时的 p95 上限 (微秒)，超过则视为失败；0 表示不检查
+void set_replay_p95_limit(double us);
+// 记录双方棋盘的当前状态，录制结束时写入校验和，回放结束时与之比较
+void note_trace_boards(const PlayerBoard& p1, const PlayerBoard& p2);
+// 结束录制或回放；回放模式下把统计结果写入 "<trace>.report"，校验失败时返回 false
+bool finish_input_trace();
+InputMode current_input_mode();
+
+// 以下函数替代 peekmessage / getmessage / FlushBatchDraw / Sleep，在三种模式下行为一致
+bool poll_input(ExMessage* msg, BYTE filter);
+ExMessage wait_input(BYTE filter);
+void present_frame();
+void frame_sleep(DWORD ms); // 回放时不等待，尽可能快地跑完整个 trace
@@ -1,8 +1,16 @@
-#include <conio.h>
 #include "common.h"
 #include "graphics.h"
 #include "game_logic.h"
 #include "ai_player.h"
+#include "input_trace.h"
+#include "opening_book.h"
+#include "policy_net.h"
+#include "spectator.h"
+#include "text_cache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 
 // --- 函数声明 ---
 // 从 graphics.cpp 引入的函数
@@ -14,22 +22,99 @@ void game_loop(GameMode mode);
 void placement_phase(PlayerBoard& board, const std::wstring& player_name);
 void show_transition_screen(const std::wstring& text);
 void create_gradient_background();
+static TraceEnvironment current_trace_environment(unsigned int seed);
+static bool same_ai_environment(const TraceEnvironment& recorded, const TraceEnvironment& current);
 
 
-int main() {
+/**
+ * 命令行参数：
+ *   --record <file>  正常游戏，同时把输入事件录制到文件
+ *   --replay <file>  不等待玩家，按录制的输入尽快回放一遍，统计结果写入 <file>.report；
+ *                    AI 环境与录制时不同、结束时棋盘与录制时不同或超过 p95 上限时返回非零
+ *   --max-p95-us <n> 回放时每个事件耗时的 p95 上限 (微秒)
+ *   --build-book <file>  不启动游戏，离线生成开局库后退出
+ *   --spectate <n>   不进入主菜单，直接打开同时显示 n 局 AI 对战的观战墙
+ */
+int main(int argc, char* argv[]) {
+    // 随机种子统一在这里设置，回放时使用录制时的种子，保证AI行为一致
+    unsigned int seed = static_cast<unsigned int>(time(nullptr));
+    int spectate_games = 0;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--record") == 0) {
+            if (!start_input_recording(argv[i + 1], current_trace_environment(seed))) return 1;
+        }
+        else if (strcmp(argv[i], "--replay") == 0) {
+            TraceEnvironment recorded;
+            if (!start_input_replay(argv[i + 1], recorded)) {
+                fprintf(stderr, "cannot read trace %s\n", argv[i + 1]);
+                return 1;
+            }
+            // 策略网络或开局库与录制时不同，同样的输入会作用在不同的对局上
+            if (!same_ai_environment(recorded, current_trace_environment(recorded.seed))) {
+                fprintf(stderr, "trace %s was recorded with a different %s or %s\n", argv[i + 1], POLICY_FILE, OPENING_BOOK_FILE);
+                return 1;
+            }
+            seed = recorded.seed;
+        }
+        else if (strcmp(argv[i], "--max-p95-us") == 0) {
+            set_replay_p95_limit(atof(argv[i + 1]));
+        }
+        else if (strcmp(argv[i], "--build-book") == 0) {
+            srand(seed);
+            return build_opening_book(argv[i + 1], 12, 4000, 2000) ? 0 : 1;
+        }
+        else if (strcmp(argv[i], "--spectate") == 0) {
+            spectate_games = atoi(argv[i + 1]);
+        }
+    }
+    srand(seed);
+
+#ifdef SEAWAR_HEADLESS
+    // 无界面版本没有实时输入，只能回放
+    if (current_input_mode() != InputMode::REPLAY) {
+        fprintf(stderr, "headless build: use --replay <file> or --build-book <file>\n");
+        return 1;
+    }
+#endif
+
     initgraph(WINDOW_WIDTH, WINDOW_HEIGHT);
     g_imgGradientBg.Resize(WINDOW_WIDTH, WINDOW_HEIGHT);
     create_gradient_background();
     // 开启批量绘图模式，防止画面闪烁。包裹整个程序生命周期。
     BeginBatchDraw();
 
-    // 进入主菜单循环
-    main_menu_loop();
+    // 进入主菜单循环 (或观战墙)
+    if (spectate_games > 0) {
+        run_spectator_wall(spectate_games);
+    }
+    else {
+        main_menu_loop();
+    }
+
+    bool trace_ok = finish_input_trace();
 
     // 结束批量绘图
     EndBatchDraw();
     closegraph();
-    return 0;
+    return trace_ok ? 0 : 1;
+}
+
+/**
+ * @brief 收集会影响 AI 行为的运行环境，写入 trace 头或与之比较。
+ */
+static TraceEnvironment current_trace_environment(unsigned int seed) {
+    TraceEnvironment env;
+    env.seed = seed;
+    env.policy_loaded = shared_policy_net().is_loaded();
+    env.policy_hash = shared_policy_net().content_hash();
+    env.book_loaded = shared_opening_book().is_loaded();
+    env.book_hash = shared_opening_book().content_hash();
+    return env;
+}
+
+static bool same_ai_environment(const TraceEnvironment& recorded, const TraceEnvironment& current) {
+    return recorded.policy_loaded == current.policy_loaded && recorded.policy_hash == current.policy_hash &&
+        recorded.book_loaded == current.book_loaded && recorded.book_hash == current.book_hash;
 }
 
 /**
@@ -38,17 +123,14 @@ int main() {
  */
 void show_transition_screen(const std::wstring& text) {
     draw_background(); // 绘制渐变色背景
-    setbkmode(TRANSPARENT);
-    settextcolor(WHITE);
-    settextstyle(30, 0, L"微软雅黑");
     // 计算文本居中位置
-    int text_w = textwidth(text.c_str());
-    outtextxy((WINDOW_WIDTH - text_w) / 2, WINDOW_HEIGHT / 2 - 15, text.c_str());
-    FlushBatchDraw();
+    int text_w = cached_text_width(text.c_str(), 30, L"微软雅黑", WHITE);
+    draw_cached_text((WINDOW_WIDTH - text_w) / 2, WINDOW_HEIGHT / 2 - 15, text.c_str(), 30, L"微软雅黑", WHITE);
+    present_frame();
     //_getch(); // 等待任意键按下
     ExMessage tmp;
     while (true) {
-		tmp = getmessage(EX_KEY);
+		tmp = wait_input(EX_KEY);
         if (tmp.message == WM_KEYDOWN) {
             break; // 只要有键盘点击事件就退出
 		}
@@ -66,10 +148,10 @@ void main_menu_loop() {
         // 绘制背景和菜单
         draw_background();
         draw_main_menu(selected_item);
-        FlushBatchDraw();
+        present_frame();
 
         // 检查鼠标消息
-        if (peekmessage(&msg, EX_MOUSE)) {
+        if (poll_input(&msg, EX_MOUSE)) {
             // 鼠标悬停检测
             if (msg.message == WM_MOUSEMOVE) {
                 if (msg.x > 300 && msg.x < 600) {
@@ -96,7 +178,7 @@ void main_menu_loop() {
                 }
             }
         }
-        Sleep(10);
+        frame_sleep(10);
     }
 }
 
@@ -125,6 +207,8 @@ void game_loop(GameMode mode) {
     ExMessage msg;
 
     while (true) {
+        note_trace_boards(p1_board, p2_board);
+
         // 检查游戏是否结束
         if (check_game_over(p1_board) || check_game_over(p2_board)) {
             current_state = GameState::GAME_OVER;
@@ -133,11 +217,11 @@ void game_loop(GameMode mode) {
         // 统一绘制背景和游戏界面
         draw_background();
         draw_game_interface(p1_board, p2_board, current_state, mode);
-        FlushBatchDraw();
+        present_frame();
 
         // 如果游戏结束，显示结果几秒后退出循环
         if (current_state == GameState::GAME_OVER) {
-            Sleep(3000);
+            frame_sleep(3000);
             break;
         }
 
@@ -146,7 +230,7 @@ void game_loop(GameMode mode) {
         // --- 3. 根据当前回合处理玩家或AI的输入 ---
         switch (current_state) {
         case GameState::PLAYER1_TURN:
-            if (peekmessage(&msg, EX_MOUSE) && msg.message == WM_LBUTTONDOWN) {
+            if (poll_input(&msg, EX_MOUSE) && msg.message == WM_LBUTTONDOWN) {
                 int p2_board_x = WINDOW_WIDTH - 50 - GRID_SIZE * CELL_SIZE;
                 Point shot = get_grid_click(msg.x, msg.y, p2_board_x, 100);
                 if (shot.r != -1 && p2_board.grid[shot.r][shot.c] < CellState::HIT) {
@@ -158,7 +242,7 @@ void game_loop(GameMode mode) {
             break;
 
         case GameState::PLAYER2_TURN: // 仅在PVP模式下有效
-            if (mode == GameMode::PLAYER_VS_PLAYER && peekmessage(&msg, EX_MOUSE) && msg.message == WM_LBUTTONDOWN) {
+            if (mode == GameMode::PLAYER_VS_PLAYER && poll_input(&msg, EX_MOUSE) && msg.message == WM_LBUTTONDOWN) {
                 int p1_board_x = 50;
                 Point shot = get_grid_click(msg.x, msg.y, p1_board_x, 100);
                 if (shot.r != -1 && p1_board.grid[shot.r][shot.c] < CellState::HIT) {
@@ -171,7 +255,7 @@ void game_loop(GameMode mode) {
 
         case GameState::AI_TURN: // 仅在PVE模式下有效
             if (mode == GameMode::PLAYER_VS_AI) {
-                Sleep(500); // 模拟AI思考
+                frame_sleep(500); // 模拟AI思考
 
                 // 1. AI根据当前状态决定射击点
                 Point shot = ai.make_shot(p1_board.grid);
@@ -223,7 +307,7 @@ void game_loop(GameMode mode) {
                 }
             }
         }
-        Sleep(1);
+        frame_sleep(1);
     }
 }
 
@@ -241,11 +325,13 @@ void placement_phase(PlayerBoard& board, const std::wstring& player_name) {
     preview_ship.is_sunk = false;
 
     ExMessage msg;
+    std::wstring hint;  // 提示信息只在舰船大小变化时重新生成
+    int hint_ship_size = -1;
     while (current_ship_idx < SHIP_SIZES.size()) {
         preview_ship.size = SHIP_SIZES[current_ship_idx];
 
         // 持续获取鼠标和键盘消息
-        if (peekmessage(&msg, EX_MOUSE | EX_KEY)) {
+        if (poll_input(&msg, EX_MOUSE | EX_KEY)) {
             // 获取鼠标在网格中的位置
             Point grid_pos = get_grid_click(msg.x, msg.y, 100, 60);
             if (grid_pos.r != -1) {
@@ -271,13 +357,13 @@ void placement_phase(PlayerBoard& board, const std::wstring& player_name) {
         draw_placement_screen(board, preview_ship, is_valid_now);
 
         // 动态显示提示信息
-        std::wstring hint = player_name + L", 请放置你的 " + std::to_wstring(preview_ship.size) + L" 格舰船";
-        setbkmode(TRANSPARENT);
-        settextcolor(WHITE);
-        settextstyle(24, 0, L"微软雅黑");
-        outtextxy(100, 420, hint.c_str());
-
-        FlushBatchDraw();
-        Sleep(10);
+        if (preview_ship.size != hint_ship_size) {
+            hint = player_name + L", 请放置你的 " + std::to_wstring(preview_ship.size) + L" 格舰船";
+            hint_ship_size = preview_ship.size;
+        }
+        draw_cached_text(100, 420, hint.c_str(), 24, L"微软雅黑", WHITE);
+
+        present_frame();
+        frame_sleep(10);
     }
 }
\ No newline at end of file
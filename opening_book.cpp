@@ -0,0 +1,288 @@
+// opening_book.cpp
+#include "opening_book.h"
+#include "ai_player.h"
+#include "game_logic.h"
+#include "resource_path.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static const char BOOK_MAGIC[4] = { 'S', 'W', 'O', 'B' };
+static const uint32_t BOOK_VERSION = 1;
+static const uint64_t BOOK_HEADER_SIZE = 16;
+static const uint64_t CELL_MASK = 0x7F; // 低 7 位存放格子编号
+
+// splitmix64，用来为每个 (格子, 状态) 生成固定的 Zobrist 随机数，不需要额外存表
+static uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// 局面哈希去掉低 7 位后作为标签，保证非零以区分空位
+static uint64_t hash_tag(uint64_t hash) {
+    uint64_t tag = hash & ~CELL_MASK;
+    return tag != 0 ? tag : (CELL_MASK + 1);
+}
+
+// 对称变换：bit0 转置，bit1 上下翻转，bit2 左右翻转 (按此顺序施加)
+static Point apply_symmetry(Point p, int symmetry) {
+    if (symmetry & 1) std::swap(p.r, p.c);
+    if (symmetry & 2) p.r = GRID_SIZE - 1 - p.r;
+    if (symmetry & 4) p.c = GRID_SIZE - 1 - p.c;
+    return p;
+}
+
+static Point invert_symmetry(Point p, int symmetry) {
+    if (symmetry & 4) p.c = GRID_SIZE - 1 - p.c;
+    if (symmetry & 2) p.r = GRID_SIZE - 1 - p.r;
+    if (symmetry & 1) std::swap(p.r, p.c);
+    return p;
+}
+
+OpeningBook::OpeningBook() : m_depth(0) {
+}
+
+uint64_t OpeningBook::hash_view(const CellState view[GRID_SIZE][GRID_SIZE]) {
+    uint64_t hash = 0;
+    for (int r = 0; r < GRID_SIZE; ++r) {
+        for (int c = 0; c < GRID_SIZE; ++c) {
+            if (view[r][c] < CellState::HIT) continue; // 未射击 (EMPTY/SHIP) 不参与哈希
+            uint64_t cell = static_cast<uint64_t>(r * GRID_SIZE + c);
+            hash ^= mix64(cell * 8 + static_cast<uint64_t>(view[r][c]));
+        }
+    }
+    return hash;
+}
+
+int OpeningBook::count_shots(const CellState view[GRID_SIZE][GRID_SIZE]) {
+    int shots = 0;
+    for (int r = 0; r < GRID_SIZE; ++r) {
+        for (int c = 0; c < GRID_SIZE; ++c) {
+            if (view[r][c] >= CellState::HIT) ++shots;
+        }
+    }
+    return shots;
+}
+
+uint64_t OpeningBook::content_hash() const {
+    if (!is_loaded()) return 0;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    hash ^= static_cast<uint64_t>(m_depth);
+    hash *= 0x100000001B3ULL;
+    for (uint64_t entry : m_table) {
+        hash ^= entry;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+void OpeningBook::assign(const std::unordered_map<uint64_t, int>& entries, int depth) {
+    // 装载因子不超过 1/2，线性探测的平均查找次数接近常数
+    size_t capacity = 16;
+    while (capacity < entries.size() * 2) capacity *= 2;
+    m_table.assign(capacity, 0);
+    m_depth = depth;
+
+    for (const auto& entry : entries) {
+        uint64_t tag = hash_tag(entry.first);
+        size_t slot = static_cast<size_t>(entry.first) & (capacity - 1);
+        while (m_table[slot] != 0) slot = (slot + 1) & (capacity - 1);
+        m_table[slot] = tag | static_cast<uint64_t>(entry.second);
+    }
+}
+
+bool OpeningBook::lookup(const CellState view[GRID_SIZE][GRID_SIZE], Point& shot, int symmetry) const {
+    if (m_table.empty() || count_shots(view) >= m_depth) return false;
+
+    CellState transformed[GRID_SIZE][GRID_SIZE];
+    for (int r = 0; r < GRID_SIZE; ++r) {
+        for (int c = 0; c < GRID_SIZE; ++c) {
+            Point p = apply_symmetry({ r, c }, symmetry);
+            transformed[p.r][p.c] = view[r][c];
+        }
+    }
+
+    uint64_t hash = hash_view(transformed);
+    uint64_t tag = hash_tag(hash);
+    size_t mask = m_table.size() - 1;
+    // 最多探测 capacity 次，即使表被填满也不会死循环
+    size_t slot = static_cast<size_t>(hash) & mask;
+    for (size_t probes = 0; probes < m_table.size() && m_table[slot] != 0; ++probes, slot = (slot + 1) & mask) {
+        if ((m_table[slot] & ~CELL_MASK) == tag) {
+            int cell = static_cast<int>(m_table[slot] & CELL_MASK);
+            shot = invert_symmetry({ cell / GRID_SIZE, cell % GRID_SIZE }, symmetry);
+            // 哈希冲突时表项可能指向已经打过的格子，此时当作未命中
+            return view[shot.r][shot.c] < CellState::HIT;
+        }
+    }
+    return false;
+}
+
+bool OpeningBook::load(const std::string& path) {
+    m_table.clear();
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) return false;
+
+    fseek(fp, 0, SEEK_END);
+    long file_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    char magic[4];
+    uint32_t version = 0, depth = 0, capacity = 0;
+    bool ok = fread(magic, 1, 4, fp) == 4 && memcmp(magic, BOOK_MAGIC, 4) == 0 &&
+        fread(&version, 4, 1, fp) == 1 && version == BOOK_VERSION &&
+        fread(&depth, 4, 1, fp) == 1 &&
+        fread(&capacity, 4, 1, fp) == 1 && capacity != 0 && (capacity & (capacity - 1)) == 0;
+    // 先核对文件长度再分配内存，避免文件头给出一个巨大的容量
+    ok = ok && file_size >= 0 &&
+        static_cast<uint64_t>(file_size) == BOOK_HEADER_SIZE + static_cast<uint64_t>(capacity) * sizeof(uint64_t);
+    if (ok) {
+        m_table.resize(capacity);
+        ok = fread(m_table.data(), sizeof(uint64_t), capacity, fp) == capacity;
+    }
+    fclose(fp);
+
+    // 与 assign 一致：装载因子不超过 1/2 (保证有空位，探测能终止)，格子编号必须在棋盘内
+    size_t used = 0;
+    for (size_t i = 0; ok && i < m_table.size(); ++i) {
+        if (m_table[i] == 0) continue;
+        ++used;
+        ok = (m_table[i] & CELL_MASK) < static_cast<uint64_t>(GRID_SIZE * GRID_SIZE);
+    }
+    ok = ok && used * 2 <= m_table.size();
+
+    if (!ok) {
+        m_table.clear();
+        return false;
+    }
+    m_depth = static_cast<int>(depth);
+    return true;
+}
+
+bool OpeningBook::save(const std::string& path) const {
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) return false;
+    uint32_t version = BOOK_VERSION;
+    uint32_t depth = static_cast<uint32_t>(m_depth);
+    uint32_t capacity = static_cast<uint32_t>(m_table.size());
+    bool ok = fwrite(BOOK_MAGIC, 1, 4, fp) == 4 &&
+        fwrite(&version, 4, 1, fp) == 1 &&
+        fwrite(&depth, 4, 1, fp) == 1 &&
+        fwrite(&capacity, 4, 1, fp) == 1 &&
+        fwrite(m_table.data(), sizeof(uint64_t), capacity, fp) == capacity;
+    fclose(fp);
+    return ok;
+}
+
+const OpeningBook& shared_opening_book() {
+    static OpeningBook book;
+    static const bool loaded = book.load(executable_relative_path(OPENING_BOOK_FILE));
+    (void)loaded;
+    return book;
+}
+
+// --- 离线生成 ---
+
+// 模拟中遇到的局面
+struct BookPosition {
+    int count;
+    CellState view[GRID_SIZE][GRID_SIZE];
+};
+
+// 随机布局是否与已知的射击结果一致
+static bool fleet_matches_view(const PlayerBoard& fleet, const CellState view[GRID_SIZE][GRID_SIZE]) {
+    for (int r = 0; r < GRID_SIZE; ++r) {
+        for (int c = 0; c < GRID_SIZE; ++c) {
+            bool has_ship = fleet.grid[r][c] == CellState::SHIP;
+            if (view[r][c] == CellState::MISS && has_ship) return false;
+            if ((view[r][c] == CellState::HIT || view[r][c] == CellState::SUNK) && !has_ship) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 用与 AIPlayer::place_ships 相同分布的随机布局估计每个未探索格子有船的概率，返回概率最大的格子编号。
+ */
+static int best_shot_by_sampling(const CellState view[GRID_SIZE][GRID_SIZE], int samples) {
+    int hits[GRID_SIZE * GRID_SIZE] = {};
+    AIPlayer placer;
+    PlayerBoard fleet;
+    int accepted = 0;
+    for (int attempt = 0; accepted < samples && attempt < samples * 200; ++attempt) {
+        placer.place_ships(fleet);
+        if (!fleet_matches_view(fleet, view)) continue;
+        ++accepted;
+        for (int r = 0; r < GRID_SIZE; ++r) {
+            for (int c = 0; c < GRID_SIZE; ++c) {
+                if (fleet.grid[r][c] == CellState::SHIP) ++hits[r * GRID_SIZE + c];
+            }
+        }
+    }
+    if (accepted == 0) return -1;
+
+    int best = -1;
+    for (int cell = 0; cell < GRID_SIZE * GRID_SIZE; ++cell) {
+        if (view[cell / GRID_SIZE][cell % GRID_SIZE] >= CellState::HIT) continue;
+        if (best == -1 || hits[cell] > hits[best]) best = cell;
+    }
+    return best;
+}
+
+bool build_opening_book(const std::string& path, int depth, int games, int samples) {
+    const size_t MAX_POSITIONS_PER_DEPTH = 64;
+    std::unordered_map<uint64_t, int> entries;
+    OpeningBook book;
+
+    // 逐层生成：用已生成的浅层开局库模拟对局，收集AI在第 d 手搜索时实际遇到的局面
+    for (int d = 0; d < depth; ++d) {
+        book.assign(entries, depth);
+        std::unordered_map<uint64_t, BookPosition> positions;
+
+        for (int g = 0; g < games; ++g) {
+            PlayerBoard target;
+            AIPlayer ai;
+            ai.place_ships(target);
+            ai.set_opening_book(&book, 0); // 生成时不做变换，收集到的局面与表中的键一致
+
+            while (!check_game_over(target)) {
+                if (OpeningBook::count_shots(target.grid) == d) {
+                    if (ai.is_hunting()) {
+                        BookPosition& pos = positions[OpeningBook::hash_view(target.grid)];
+                        if (pos.count++ == 0) {
+                            for (int r = 0; r < GRID_SIZE; ++r) {
+                                for (int c = 0; c < GRID_SIZE; ++c) {
+                                    CellState s = target.grid[r][c];
+                                    pos.view[r][c] = (s == CellState::SHIP) ? CellState::EMPTY : s;
+                                }
+                            }
+                        }
+                    }
+                    break;
+                }
+                // 与 game_loop 中的调用方式保持一致
+                Point shot = ai.make_shot(target.grid);
+                CellState result = process_shot(target, shot);
+                ai.report_shot_result(shot, result);
+            }
+        }
+
+        // 只为出现频率足够高的局面计算最佳射击 (至少 1% 的对局)
+        std::vector<std::pair<int, uint64_t>> frequent;
+        for (const auto& pos : positions) {
+            if (pos.second.count * 100 >= games) frequent.push_back({ pos.second.count, pos.first });
+        }
+        std::sort(frequent.rbegin(), frequent.rend());
+        if (frequent.size() > MAX_POSITIONS_PER_DEPTH) frequent.resize(MAX_POSITIONS_PER_DEPTH);
+
+        for (const auto& item : frequent) {
+            int cell = best_shot_by_sampling(positions[item.second].view, samples);
+            if (cell != -1) entries[item.second] = cell;
+        }
+    }
+
+    book.assign(entries, depth);
+    return book.save(path);
+}
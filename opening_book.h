@@ -0,0 +1,61 @@
+// opening_book.h
+#pragma once
+#include "common.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 开局库文件名，从可执行文件所在目录加载 (见 executable_relative_path)
+const char* const OPENING_BOOK_FILE = "opening.book";
+// 正方形棋盘的 8 种对称变换 (转置 / 上下翻转 / 左右翻转的组合)
+const int BOOK_SYMMETRIES = 8;
+
+/**
+ * @brief 搜索阶段的开局库：以已射击过的格子及其结果为键，查出下一手的最佳射击位置。
+ *
+ * 文件布局 (小端序)：
+ *   header : "SWOB", uint32 版本号, uint32 深度 N (只对前 N 手生效), uint32 容量 (2 的幂)
+ *   table  : uint64 [容量]，开放寻址哈希表；每项高 57 位是局面哈希，低 7 位是格子编号 r * GRID_SIZE + c，0 表示空位
+ *
+ * 加载时把整个表读入内存而不是内存映射：表只有几十 KB，加载时本来就要逐项校验，
+ * 而且内存映射需要分别为 Windows 和其他平台写代码。
+ *
+ * 随机布局的分布在 8 种对称变换下不变，所以查表前可以先把局面变换一次，再把结果变换回来，
+ * 得到的射击位置同样是最佳的。每个 AIPlayer 随机选一种变换，玩家无法记住固定的开局射击顺序。
+ */
+class OpeningBook {
+public:
+    OpeningBook();
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    bool is_loaded() const { return !m_table.empty(); }
+    int depth() const { return m_depth; }
+    // 深度和哈希表内容的 FNV-1a 哈希，用于确认录制和回放时加载的是同一份开局库；未加载时为 0
+    uint64_t content_hash() const;
+
+    // 用局面哈希 -> 格子编号的映射重建哈希表
+    void assign(const std::unordered_map<uint64_t, int>& entries, int depth);
+    // 在 symmetry (0 ~ BOOK_SYMMETRIES - 1) 变换后的局面中查表，命中时返回 true 并写入变换回原局面的 shot
+    bool lookup(const CellState view[GRID_SIZE][GRID_SIZE], Point& shot, int symmetry = 0) const;
+
+    // 局面哈希只取决于已射击格子的位置和结果，对手未被击中的船 (SHIP) 视为未探索
+    static uint64_t hash_view(const CellState view[GRID_SIZE][GRID_SIZE]);
+    static int count_shots(const CellState view[GRID_SIZE][GRID_SIZE]);
+
+private:
+    std::vector<uint64_t> m_table;
+    int m_depth;
+};
+
+// 全局共享的开局库，首次调用时从 OPENING_BOOK_FILE 加载；文件不存在时 is_loaded() 为 false
+const OpeningBook& shared_opening_book();
+
+/**
+ * @brief 离线生成开局库。
+ * @param path 输出文件路径。
+ * @param depth 开局库覆盖的手数。
+ * @param games 每一层模拟的对局数，用于找出AI实际会遇到的局面。
+ * @param samples 每个局面用于估计格子命中概率的随机布局数。
+ */
+bool build_opening_book(const std::string& path, int depth, int games, int samples);
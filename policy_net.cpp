@@ -0,0 +1,200 @@
+// policy_net.cpp
+#include "policy_net.h"
+#include "resource_path.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
+static const char POLICY_MAGIC[4] = { 'S', 'W', 'P', 'N' };
+static const uint16_t POLICY_VERSION = 1;
+static const size_t POLICY_HEADER_SIZE = 16;
+
+/**
+ * @brief int8 点积内核：a 为非负激活值 (0~127)，w 为有符号权重，n 必须是 32 的倍数。
+ */
+static int32_t dot_u8_s8(const uint8_t* a, const int8_t* w, int n) {
+#if defined(__AVX2__)
+    // maddubs 把相邻两对 u8*s8 相加为 s16；激活值不超过 127，因此不会饱和
+    __m256i acc = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi16(1);
+    for (int i = 0; i < n; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(va, vw), ones));
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_hadd_epi32(sum, sum);
+    sum = _mm_hadd_epi32(sum, sum);
+    return _mm_cvtsi128_si32(sum);
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    int32x4_t acc = vdupq_n_s32(0);
+    for (int i = 0; i < n; i += 16) {
+        int8x16_t va = vreinterpretq_s8_u8(vld1q_u8(a + i));
+        int8x16_t vw = vld1q_s8(w + i);
+        acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(va), vget_low_s8(vw)));
+        acc = vpadalq_s16(acc, vmull_s8(vget_high_s8(va), vget_high_s8(vw)));
+    }
+    return vgetq_lane_s32(acc, 0) + vgetq_lane_s32(acc, 1) + vgetq_lane_s32(acc, 2) + vgetq_lane_s32(acc, 3);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += static_cast<int32_t>(a[i]) * w[i];
+    }
+    return sum;
+#endif
+}
+
+// 把棋盘视图编码为输入平面。SHIP 是对手的真实布局，AI 不应看到，按 EMPTY 处理
+static void encode_view(const CellState view[GRID_SIZE][GRID_SIZE], uint8_t* input) {
+    const int plane = GRID_SIZE * GRID_SIZE;
+    memset(input, 0, POLICY_INPUTS_PADDED);
+    for (int r = 0; r < GRID_SIZE; ++r) {
+        for (int c = 0; c < GRID_SIZE; ++c) {
+            int idx = r * GRID_SIZE + c;
+            switch (view[r][c]) {
+            case CellState::MISS: input[plane + idx] = 1; break;
+            case CellState::HIT:
+            case CellState::SUNK: input[2 * plane + idx] = 1; break;
+            default:              input[idx] = 1; break;
+            }
+        }
+    }
+}
+
+PolicyNet::PolicyNet()
+    : m_hidden(0), m_shift(0), m_w1(nullptr), m_b1(nullptr), m_w2(nullptr), m_b2(nullptr) {
+}
+
+bool PolicyNet::load(const std::string& path) {
+    m_hidden = 0;
+    m_blob.clear();
+
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) return false;
+    fseek(fp, 0, SEEK_END);
+    long file_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (file_size < static_cast<long>(POLICY_HEADER_SIZE)) {
+        fclose(fp);
+        return false;
+    }
+    m_blob.resize(file_size);
+    size_t read = fread(m_blob.data(), 1, m_blob.size(), fp);
+    fclose(fp);
+    if (read != m_blob.size()) return false;
+
+    const uint8_t* p = m_blob.data();
+    uint16_t version, hidden, inputs, outputs;
+    int32_t shift;
+    memcpy(&version, p + 4, 2);
+    memcpy(&hidden, p + 6, 2);
+    memcpy(&inputs, p + 8, 2);
+    memcpy(&outputs, p + 10, 2);
+    memcpy(&shift, p + 12, 4);
+    if (memcmp(p, POLICY_MAGIC, 4) != 0 || version != POLICY_VERSION ||
+        hidden == 0 || hidden % 32 != 0 || hidden > POLICY_MAX_HIDDEN || inputs != POLICY_INPUTS_PADDED ||
+        outputs != POLICY_OUTPUTS || shift < 0 || shift > 31) {
+        return false;
+    }
+
+    size_t w1_size = static_cast<size_t>(hidden) * inputs;
+    size_t b1_size = static_cast<size_t>(hidden) * sizeof(int32_t);
+    size_t w2_size = static_cast<size_t>(outputs) * hidden;
+    size_t b2_size = static_cast<size_t>(outputs) * sizeof(int32_t);
+    if (m_blob.size() != POLICY_HEADER_SIZE + w1_size + b1_size + w2_size + b2_size) {
+        return false;
+    }
+
+    // 隐藏层宽度是 32 的倍数，各段偏移都保持 4 字节对齐，可以直接当数组使用
+    p += POLICY_HEADER_SIZE;
+    m_w1 = reinterpret_cast<const int8_t*>(p);              p += w1_size;
+    m_b1 = reinterpret_cast<const int32_t*>(p);             p += b1_size;
+    m_w2 = reinterpret_cast<const int8_t*>(p);              p += w2_size;
+    m_b2 = reinterpret_cast<const int32_t*>(p);
+    m_shift = shift;
+    m_hidden = hidden;
+    return true;
+}
+
+uint64_t PolicyNet::content_hash() const {
+    if (!is_loaded()) return 0;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (uint8_t byte : m_blob) {
+        hash ^= byte;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+void PolicyNet::evaluate(const CellState view[GRID_SIZE][GRID_SIZE], int32_t* logits) const {
+    BoardView single = view;
+    evaluate_batch(&single, 1, logits);
+}
+
+void PolicyNet::evaluate_batch(const BoardView* views, int count, int32_t* logits) const {
+    if (!is_loaded() || count <= 0) return;
+
+    // 每次处理 POLICY_BATCH_CHUNK 个棋盘，中间结果放在栈上，交互时的单次推理不分配堆内存
+    uint8_t inputs[POLICY_BATCH_CHUNK][POLICY_INPUTS_PADDED];
+    uint8_t hidden[POLICY_BATCH_CHUNK][POLICY_MAX_HIDDEN];
+    for (int first = 0; first < count; first += POLICY_BATCH_CHUNK) {
+        int n = std::min(POLICY_BATCH_CHUNK, count - first);
+        for (int b = 0; b < n; ++b) {
+            encode_view(views[first + b], inputs[b]);
+        }
+
+        // 外层遍历权重行、内层遍历批次，让每一行权重只从内存读一次
+        for (int h = 0; h < m_hidden; ++h) {
+            const int8_t* row = m_w1 + static_cast<size_t>(h) * POLICY_INPUTS_PADDED;
+            for (int b = 0; b < n; ++b) {
+                int32_t acc = dot_u8_s8(inputs[b], row, POLICY_INPUTS_PADDED) + m_b1[h];
+                acc >>= m_shift;
+                if (acc < 0) acc = 0;      // ReLU
+                if (acc > 127) acc = 127;  // 重量化回 0~127
+                hidden[b][h] = static_cast<uint8_t>(acc);
+            }
+        }
+
+        int32_t* out = logits + static_cast<size_t>(first) * POLICY_OUTPUTS;
+        for (int o = 0; o < POLICY_OUTPUTS; ++o) {
+            const int8_t* row = m_w2 + static_cast<size_t>(o) * m_hidden;
+            for (int b = 0; b < n; ++b) {
+                out[b * POLICY_OUTPUTS + o] = dot_u8_s8(hidden[b], row, m_hidden) + m_b2[o];
+            }
+        }
+    }
+}
+
+Point PolicyNet::best_shot(const CellState view[GRID_SIZE][GRID_SIZE]) const {
+    int32_t logits[POLICY_OUTPUTS];
+    evaluate(view, logits);
+
+    Point best = { -1, -1 };
+    int32_t best_score = INT_MIN;
+    for (int r = 0; r < GRID_SIZE; ++r) {
+        for (int c = 0; c < GRID_SIZE; ++c) {
+            if (view[r][c] >= CellState::HIT) continue; // 已经打过的格子不再考虑
+            int32_t score = logits[r * GRID_SIZE + c];
+            if (score > best_score) {
+                best_score = score;
+                best = { r, c };
+            }
+        }
+    }
+    return best;
+}
+
+const PolicyNet& shared_policy_net() {
+    // 局部静态变量的初始化是线程安全的，权重只会加载一次
+    static PolicyNet net;
+    static const bool loaded = net.load(executable_relative_path(POLICY_FILE));
+    (void)loaded;
+    return net;
+}
@@ -0,0 +1,64 @@
+// policy_net.h
+#pragma once
+#include "common.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 权重文件名，从可执行文件所在目录加载 (见 executable_relative_path)
+const char* const POLICY_FILE = "policy.bin";
+
+// 网络输入：3 个 10x10 平面 (未探索 / 未击中 / 击中或击沉)，补零到 32 的倍数方便 SIMD
+const int POLICY_PLANES = 3;
+const int POLICY_INPUTS = POLICY_PLANES * GRID_SIZE * GRID_SIZE;
+const int POLICY_INPUTS_PADDED = (POLICY_INPUTS + 31) / 32 * 32;
+const int POLICY_OUTPUTS = GRID_SIZE * GRID_SIZE;
+// 隐藏层宽度上限，推理时的中间结果可以放在栈上
+const int POLICY_MAX_HIDDEN = 512;
+// 批量推理时每次处理的棋盘数，中间结果约 (320 + 512) * 16 字节
+const int POLICY_BATCH_CHUNK = 16;
+
+// 指向一个 GRID_SIZE x GRID_SIZE 棋盘视图的指针，批量推理时每个元素可以来自不同的对局
+typedef const CellState (*BoardView)[GRID_SIZE];
+
+/**
+ * @brief 两层 int8 量化 MLP，输入对手棋盘视图，输出每个格子的射击得分。
+ *
+ * 权重文件布局 (小端序，各段紧密排列，可直接映射使用)：
+ *   header  : "SWPN", uint16 版本号, uint16 隐藏层宽度 H (32 的倍数，不超过 POLICY_MAX_HIDDEN),
+ *             uint16 输入宽度 (= POLICY_INPUTS_PADDED), uint16 输出宽度 (= POLICY_OUTPUTS),
+ *             int32 第一层重量化右移位数
+ *   w1      : int8  [H][POLICY_INPUTS_PADDED]
+ *   b1      : int32 [H]
+ *   w2      : int8  [POLICY_OUTPUTS][H]
+ *   b2      : int32 [POLICY_OUTPUTS]
+ */
+class PolicyNet {
+public:
+    PolicyNet();
+    PolicyNet(const PolicyNet&) = delete; // 内部指针指向 m_blob，禁止拷贝
+    PolicyNet& operator=(const PolicyNet&) = delete;
+    bool load(const std::string& path);
+    bool is_loaded() const { return m_hidden > 0; }
+    // 权重文件内容的 FNV-1a 哈希，用于确认录制和回放时加载的是同一份网络；未加载时为 0
+    uint64_t content_hash() const;
+
+    // 计算单个棋盘的 logits，结果写入 logits[POLICY_OUTPUTS]
+    void evaluate(const CellState view[GRID_SIZE][GRID_SIZE], int32_t* logits) const;
+    // 批量计算，views[i] 的结果写入 logits + i * POLICY_OUTPUTS；不分配堆内存
+    void evaluate_batch(const BoardView* views, int count, int32_t* logits) const;
+    // 在未攻击过的格子中选出得分最高的一个
+    Point best_shot(const CellState view[GRID_SIZE][GRID_SIZE]) const;
+
+private:
+    std::vector<uint8_t> m_blob; // 整个权重文件的内容，以下指针均指向其内部
+    int m_hidden;
+    int m_shift;
+    const int8_t* m_w1;
+    const int32_t* m_b1;
+    const int8_t* m_w2;
+    const int32_t* m_b2;
+};
+
+// 全局共享的策略网络，首次调用时从 POLICY_FILE 加载；文件不存在时 is_loaded() 为 false
+const PolicyNet& shared_policy_net();
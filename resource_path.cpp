@@ -0,0 +1,32 @@
+// resource_path.cpp
+#include "resource_path.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+// 可执行文件的完整路径，失败时返回空串
+static std::string executable_path() {
+#if defined(_WIN32)
+    char buffer[MAX_PATH];
+    DWORD length = GetModuleFileNameA(NULL, buffer, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH) return std::string();
+    return std::string(buffer, length);
+#elif defined(__linux__)
+    char buffer[4096];
+    ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer));
+    if (length <= 0 || length >= static_cast<ssize_t>(sizeof(buffer))) return std::string();
+    return std::string(buffer, static_cast<size_t>(length));
+#else
+    return std::string();
+#endif
+}
+
+std::string executable_relative_path(const char* file_name) {
+    std::string path = executable_path();
+    size_t slash = path.find_last_of("\\/");
+    if (slash == std::string::npos) return file_name;
+    return path.substr(0, slash + 1) + file_name;
+}
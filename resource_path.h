@@ -0,0 +1,10 @@
+// resource_path.h
+#pragma once
+#include <string>
+
+/**
+ * @brief 返回与可执行文件同目录的文件路径。
+ *        数据文件 (policy.bin / opening.book) 不依赖当前工作目录，从其他目录或 IDE 启动时也能找到；
+ *        无法取得可执行文件路径时退回到 file_name 本身 (相对当前工作目录)。
+ */
+std::string executable_relative_path(const char* file_name);
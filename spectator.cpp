@@ -0,0 +1,322 @@
+// spectator.cpp
+#include "spectator.h"
+#include "ai_player.h"
+#include "game_logic.h"
+#include "graphics.h"
+#include "input_trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+const int TILE_GAP = 6;            // 棋盘块之间的间距
+const int SIM_STEP_MS = 40;        // 每个模拟线程两轮射击之间的间隔，让比赛看得清
+const int GAME_OVER_PAUSE_STEPS = 50; // 对局结束后停留的轮数，之后开新局
+const size_t SNAPSHOT_QUEUE_SIZE = 1024; // 必须是 2 的幂
+
+// 一局比赛在某一时刻的完整状态，模拟线程每次射击后发送一份
+struct GameSnapshot {
+    int game_id;
+    CellState grids[2][GRID_SIZE][GRID_SIZE];
+};
+
+/**
+ * @brief 有界无锁多生产者多消费者队列 (Vyukov 算法)。
+ *        每个槽位带一个序号，生产者和消费者只通过 CAS 抢占位置，不会互相阻塞。
+ */
+class SnapshotQueue {
+public:
+    explicit SnapshotQueue(size_t size)
+        : m_slots(new Slot[size]), m_mask(size - 1), m_enqueue_pos(0), m_dequeue_pos(0) {
+        for (size_t i = 0; i < size; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 队列满时返回 false，由生产者决定何时重发 (见 SimGame::snapshot_pending)
+    bool push(const GameSnapshot& snapshot) {
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[pos & m_mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.data = snapshot;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(GameSnapshot& snapshot) {
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[pos & m_mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    snapshot = slot.data;
+                    slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        GameSnapshot data;
+    };
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_enqueue_pos; // 生产者与消费者的位置放在不同缓存行，避免伪共享
+    alignas(64) std::atomic<size_t> m_dequeue_pos;
+};
+
+// 模拟线程中的一局 AI 对 AI 比赛
+struct SimGame {
+    int id;
+    PlayerBoard boards[2];
+    AIPlayer ais[2];
+    int turn;           // 当前射击方，攻击 boards[1 - turn]
+    int pause_steps;    // 对局结束后剩余的停留轮数，0 表示正在进行
+    bool snapshot_pending; // 最近一份快照因队列满而没有送出
+
+    void restart() {
+        for (int i = 0; i < 2; ++i) {
+            ais[i] = AIPlayer(); // 重新构造以选择新的开局库变换
+            ais[i].place_ships(boards[i]);
+        }
+        turn = 0;
+        pause_steps = 0;
+        snapshot_pending = false;
+    }
+};
+
+// 渲染线程持有的棋盘块：缓存的位图只在收到新快照时更新，并且只重画变化的格子
+struct SpectatorTile {
+    IMAGE image;
+    CellState grids[2][GRID_SIZE][GRID_SIZE]; // 最新收到的状态
+    CellState drawn[2][GRID_SIZE][GRID_SIZE]; // 位图上当前画出的状态
+    bool dirty;
+    bool drawn_valid; // false 时需要整块重画
+};
+
+// 发送当前状态；队列满时标记为待发送，下一轮重发，保证对局结束时的最终局面一定会显示
+static void send_snapshot(SnapshotQueue& queue, SimGame& game) {
+    GameSnapshot snapshot;
+    snapshot.game_id = game.id;
+    for (int i = 0; i < 2; ++i) {
+        for (int r = 0; r < GRID_SIZE; ++r) {
+            for (int c = 0; c < GRID_SIZE; ++c) {
+                snapshot.grids[i][r][c] = game.boards[i].grid[r][c];
+            }
+        }
+    }
+    game.snapshot_pending = !queue.push(snapshot);
+}
+
+/**
+ * @brief 模拟线程：轮流推进自己负责的几局比赛，每次射击后把快照放入队列。
+ */
+static void simulation_worker(SnapshotQueue& queue, const std::atomic<bool>& stop,
+                              int first_game, int game_step, int game_count, unsigned int seed) {
+    srand(seed); // rand 的状态是线程私有的，每个线程用不同种子
+    std::vector<std::unique_ptr<SimGame>> games;
+    for (int id = first_game; id < game_count; id += game_step) {
+        std::unique_ptr<SimGame> game(new SimGame());
+        game->id = id;
+        game->restart();
+        send_snapshot(queue, *game);
+        games.push_back(std::move(game));
+    }
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        for (auto& game : games) {
+            if (game->pause_steps > 0) {
+                if (--game->pause_steps == 0) {
+                    game->restart();
+                    send_snapshot(queue, *game);
+                }
+                else if (game->snapshot_pending) {
+                    send_snapshot(queue, *game);
+                }
+                continue;
+            }
+
+            // 射击规则与 game_loop 中的 AI 回合一致：击中继续，未击中或击沉则交换
+            PlayerBoard& target = game->boards[1 - game->turn];
+            AIPlayer& ai = game->ais[game->turn];
+            Point shot = ai.make_shot(target.grid);
+            CellState result = process_shot(target, shot);
+            ai.report_shot_result(shot, result);
+            CellState after = target.grid[shot.r][shot.c];
+            if (check_game_over(target)) {
+                game->pause_steps = GAME_OVER_PAUSE_STEPS;
+            }
+            else if (after == CellState::MISS || after == CellState::SUNK) {
+                game->turn = 1 - game->turn;
+            }
+            send_snapshot(queue, *game);
+        }
+        Sleep(SIM_STEP_MS);
+    }
+}
+
+/**
+ * @brief 把一局比赛整块画到棋盘块的位图上。
+ *        每种颜色只设置一次填充色，网格线用整条直线代替逐格 rectangle。
+ */
+static void render_full_tile(SpectatorTile& tile, int cell) {
+    const CellState colored_states[] = { CellState::SHIP, CellState::HIT, CellState::MISS, CellState::SUNK };
+    int board_px = GRID_SIZE * cell;
+
+    for (int i = 0; i < 2; ++i) {
+        int x0 = i * (board_px + cell);
+        setfillcolor(get_cell_color(CellState::EMPTY));
+        solidrectangle(x0, 0, x0 + board_px, board_px);
+
+        for (CellState state : colored_states) {
+            setfillcolor(get_cell_color(state));
+            for (int r = 0; r < GRID_SIZE; ++r) {
+                for (int c = 0; c < GRID_SIZE; ++c) {
+                    if (tile.grids[i][r][c] != state) continue;
+                    int px = x0 + c * cell;
+                    int py = r * cell;
+                    solidrectangle(px, py, px + cell, py + cell);
+                }
+            }
+        }
+
+        setlinecolor(BLACK);
+        for (int k = 0; k <= GRID_SIZE; ++k) {
+            line(x0 + k * cell, 0, x0 + k * cell, board_px);
+            line(x0, k * cell, x0 + board_px, k * cell);
+        }
+    }
+}
+
+/**
+ * @brief 更新棋盘块的位图。通常每次射击只改变一两个格子，只重画这些格子及其边框。
+ */
+static void render_tile(SpectatorTile& tile, int cell) {
+    SetWorkingImage(&tile.image);
+    if (!tile.drawn_valid) {
+        render_full_tile(tile, cell);
+        tile.drawn_valid = true;
+    }
+    else {
+        int board_px = GRID_SIZE * cell;
+        setlinecolor(BLACK);
+        for (int i = 0; i < 2; ++i) {
+            int x0 = i * (board_px + cell);
+            for (int r = 0; r < GRID_SIZE; ++r) {
+                for (int c = 0; c < GRID_SIZE; ++c) {
+                    if (tile.grids[i][r][c] == tile.drawn[i][r][c]) continue;
+                    int px = x0 + c * cell;
+                    int py = r * cell;
+                    setfillcolor(get_cell_color(tile.grids[i][r][c]));
+                    solidrectangle(px, py, px + cell, py + cell);
+                    rectangle(px, py, px + cell, py + cell);
+                }
+            }
+        }
+    }
+    SetWorkingImage(NULL);
+    std::copy(&tile.grids[0][0][0], &tile.grids[0][0][0] + 2 * GRID_SIZE * GRID_SIZE, &tile.drawn[0][0][0]);
+    tile.dirty = false;
+}
+
+void run_spectator_wall(int game_count) {
+    game_count = std::max(1, std::min(game_count, SPECTATOR_MAX_GAMES));
+
+    // 每块显示两个棋盘，中间隔一个格子；选出能让格子最大的列数
+    int cols = 1, cell = 0;
+    for (int try_cols = 1; try_cols <= game_count; ++try_cols) {
+        int try_rows = (game_count + try_cols - 1) / try_cols;
+        int cell_w = (WINDOW_WIDTH - (try_cols + 1) * TILE_GAP) / try_cols / (2 * GRID_SIZE + 1);
+        int cell_h = (WINDOW_HEIGHT - (try_rows + 1) * TILE_GAP) / try_rows / GRID_SIZE;
+        int try_cell = std::min(cell_w, cell_h);
+        if (try_cell > cell) {
+            cell = try_cell;
+            cols = try_cols;
+        }
+    }
+    cell = std::max(cell, 1);
+    int tile_w = (2 * GRID_SIZE + 1) * cell + 1;
+    int tile_h = GRID_SIZE * cell + 1;
+
+    std::vector<std::unique_ptr<SpectatorTile>> tiles;
+    for (int i = 0; i < game_count; ++i) {
+        std::unique_ptr<SpectatorTile> tile(new SpectatorTile());
+        tile->image.Resize(tile_w, tile_h);
+        for (int b = 0; b < 2; ++b) {
+            for (int r = 0; r < GRID_SIZE; ++r) {
+                for (int c = 0; c < GRID_SIZE; ++c) {
+                    tile->grids[b][r][c] = CellState::EMPTY;
+                }
+            }
+        }
+        tile->dirty = true;
+        tile->drawn_valid = false;
+        tiles.push_back(std::move(tile));
+    }
+
+    // 启动模拟线程，保留一个核心给渲染
+    SnapshotQueue queue(SNAPSHOT_QUEUE_SIZE);
+    std::atomic<bool> stop(false);
+    int thread_count = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    thread_count = std::max(1, std::min(thread_count, game_count));
+    unsigned int seed = static_cast<unsigned int>(rand());
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thread_count; ++t) {
+        workers.emplace_back(simulation_worker, std::ref(queue), std::cref(stop),
+                             t, thread_count, game_count, seed + t);
+    }
+
+    ExMessage msg;
+    while (true) {
+        // 取出所有新快照，只记录最新状态，同一帧内多次更新只重画一次 (且只重画与上次画出时不同的格子)
+        GameSnapshot snapshot;
+        while (queue.pop(snapshot)) {
+            SpectatorTile& tile = *tiles[snapshot.game_id];
+            std::copy(&snapshot.grids[0][0][0], &snapshot.grids[0][0][0] + 2 * GRID_SIZE * GRID_SIZE, &tile.grids[0][0][0]);
+            tile.dirty = true;
+        }
+
+        draw_background();
+        for (int i = 0; i < game_count; ++i) {
+            SpectatorTile& tile = *tiles[i];
+            if (tile.dirty) render_tile(tile, cell);
+            int x = TILE_GAP + (i % cols) * (tile_w + TILE_GAP);
+            int y = TILE_GAP + (i / cols) * (tile_h + TILE_GAP);
+            putimage(x, y, &tile.image);
+        }
+        present_frame();
+
+        if (poll_input(&msg, EX_KEY) && msg.message == WM_KEYDOWN) break;
+        frame_sleep(16);
+    }
+
+    stop.store(true);
+    for (auto& worker : workers) worker.join();
+}
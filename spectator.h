@@ -0,0 +1,13 @@
+// spectator.h
+#pragma once
+#include "common.h"
+
+// 观战墙最多同时显示的对局数
+const int SPECTATOR_MAX_GAMES = 256;
+
+/**
+ * @brief 观战墙：后台线程同时进行多局 AI 对 AI 的对战，窗口以网格形式实时显示所有棋盘。
+ *        按任意键退出。
+ * @param game_count 同时进行的对局数 (1 ~ SPECTATOR_MAX_GAMES)。
+ */
+void run_spectator_wall(int game_count);
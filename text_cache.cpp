@@ -0,0 +1,118 @@
+// text_cache.cpp
+#include "text_cache.h"
+#include <algorithm>
+#include <cstdint>
+#include <cwchar>
+#include <string>
+#include <unordered_map>
+
+// 一段已经光栅化的文字。用两张图实现透明贴图：
+// mask 为白底黑字，先用 SRCAND 在背景上挖出文字；image 为黑底彩色字，再用 SRCPAINT 填上颜色。
+// 按位与/或只对纯黑白的像素是精确的，所以缓存的文字关闭了抗锯齿 (见 set_cached_font)
+struct CachedText {
+    std::wstring text;
+    std::wstring face;
+    int height;
+    COLORREF color;
+    int width;
+    IMAGE image;
+    IMAGE mask;
+};
+
+// 以内容哈希为键，unordered_map 的节点不会移动，IMAGE 不会被拷贝
+static std::unordered_map<uint64_t, CachedText> s_text_cache;
+
+// FNV-1a，直接对 wchar_t 字符串计算，命中缓存时不需要构造 std::wstring
+static uint64_t hash_text(const wchar_t* text, int height, const wchar_t* face, COLORREF color) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    auto mix = [&hash](uint64_t v) {
+        hash ^= v;
+        hash *= 0x100000001B3ULL;
+    };
+    for (const wchar_t* p = text; *p; ++p) mix(static_cast<uint64_t>(*p));
+    mix(0);
+    for (const wchar_t* p = face; *p; ++p) mix(static_cast<uint64_t>(*p));
+    mix(static_cast<uint64_t>(height));
+    mix(static_cast<uint64_t>(color));
+    return hash;
+}
+
+// 设置不抗锯齿的字体。抗锯齿或 ClearType 会产生灰色的边缘像素，与渐变背景按位与/或后出现杂色
+static void set_cached_font(int height, const wchar_t* face) {
+    LOGFONT font;
+    gettextstyle(&font);
+    font.lfHeight = height;
+    font.lfWidth = 0;
+    font.lfQuality = NONANTIALIASED_QUALITY;
+    size_t length = std::min(wcslen(face), static_cast<size_t>(LF_FACESIZE - 1));
+    wmemcpy(font.lfFaceName, face, length);
+    font.lfFaceName[length] = L'\0';
+    settextstyle(&font);
+}
+
+static void render_into(IMAGE& target, const CachedText& entry, COLORREF bk_color, COLORREF text_color) {
+    SetWorkingImage(&target);
+    setbkcolor(bk_color);
+    cleardevice();
+    setbkmode(TRANSPARENT);
+    settextcolor(text_color);
+    set_cached_font(entry.height, entry.face.c_str());
+    outtextxy(0, 0, entry.text.c_str());
+}
+
+/**
+ * @brief 查找缓存，未命中时光栅化并加入缓存。哈希冲突 (内容不同) 时返回 nullptr。
+ */
+static const CachedText* get_cached_text(const wchar_t* text, int height, const wchar_t* face, COLORREF color) {
+    uint64_t key = hash_text(text, height, face, color);
+    auto it = s_text_cache.find(key);
+    if (it != s_text_cache.end()) {
+        const CachedText& entry = it->second;
+        bool same = entry.height == height && entry.color == color &&
+            wcscmp(entry.text.c_str(), text) == 0 && wcscmp(entry.face.c_str(), face) == 0;
+        return same ? &entry : nullptr;
+    }
+
+    CachedText& entry = s_text_cache[key];
+    entry.text = text;
+    entry.face = face;
+    entry.height = height;
+    entry.color = color;
+
+    // 在窗口上测量尺寸 (调用前工作区总是窗口)
+    set_cached_font(height, face);
+    entry.width = textwidth(text);
+    int text_h = textheight(text);
+    entry.image.Resize(entry.width, text_h);
+    entry.mask.Resize(entry.width, text_h);
+
+    render_into(entry.mask, entry, WHITE, BLACK);
+    render_into(entry.image, entry, BLACK, color);
+    SetWorkingImage(NULL);
+    return &entry;
+}
+
+void draw_cached_text(int x, int y, const wchar_t* text, int height, const wchar_t* face, COLORREF color) {
+    if (*text == L'\0') return; // 空字符串无法创建 0 宽度的 IMAGE
+    const CachedText* entry = get_cached_text(text, height, face, color);
+    if (!entry) {
+        // 极少见的哈希冲突，直接绘制
+        setbkmode(TRANSPARENT);
+        settextcolor(color);
+        settextstyle(height, 0, face);
+        outtextxy(x, y, text);
+        return;
+    }
+    putimage(x, y, &entry->mask, SRCAND);
+    putimage(x, y, &entry->image, SRCPAINT);
+}
+
+int cached_text_width(const wchar_t* text, int height, const wchar_t* face, COLORREF color) {
+    if (*text == L'\0') return 0;
+    const CachedText* entry = get_cached_text(text, height, face, color);
+    if (!entry) {
+        settextstyle(height, 0, face);
+        return textwidth(text);
+    }
+    return entry->width;
+}
@@ -0,0 +1,8 @@
+// text_cache.h
+#pragma once
+#include "common.h"
+
+// 绘制一段文字 (背景透明)。同一组 (文字, 字号, 字体, 颜色) 只在第一次使用时光栅化到离屏 IMAGE，之后直接贴图
+void draw_cached_text(int x, int y, const wchar_t* text, int height, const wchar_t* face, COLORREF color);
+// 返回文字的像素宽度，与 draw_cached_text 共用同一份缓存
+int cached_text_width(const wchar_t* text, int height, const wchar_t* face, COLORREF color);